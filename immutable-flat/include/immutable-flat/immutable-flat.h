@@ -0,0 +1,334 @@
+#pragma once
+#include <immutable-flat/export.h>
+#include <immutable-optional/immutable-optional.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define IMMUTABLE_FLAT_SSE2 1
+#endif
+
+namespace imm {
+
+    namespace detail {
+
+        static constexpr std::size_t cache_line_size = 64;
+
+        // std::allocator only guarantees alignof(std::max_align_t) before C++17,
+        // so over-allocate and keep the pointer returned by `operator new` right
+        // in front of the aligned block.
+        template <typename T>
+        struct cache_aligned_allocator {
+            using value_type = T;
+
+            cache_aligned_allocator() = default;
+
+            template <typename U>
+            cache_aligned_allocator(cache_aligned_allocator<U> const&) noexcept {}
+
+            T* allocate(std::size_t n) {
+                auto const raw = static_cast<char*>(::operator new(n * sizeof(T) + cache_line_size));
+                auto const aligned = raw + cache_line_size - reinterpret_cast<std::uintptr_t>(raw) % cache_line_size;
+                reinterpret_cast<void**>(aligned)[-1] = raw;
+                return reinterpret_cast<T*>(aligned);
+            }
+
+            void deallocate(T* p, std::size_t) noexcept {
+                ::operator delete(reinterpret_cast<void**>(p)[-1]);
+            }
+
+            friend bool operator == (cache_aligned_allocator const&, cache_aligned_allocator const&) { return true; }
+            friend bool operator != (cache_aligned_allocator const&, cache_aligned_allocator const&) { return false; }
+        };
+
+        // Keys per block: one cache line worth, but at least two.
+        template <typename Key>
+        struct stree_block_size
+            : std::integral_constant<std::size_t, (2 * sizeof(Key) > cache_line_size) ? 2 : cache_line_size / sizeof(Key)>
+        {};
+
+        // Counts the keys of a block that are less than `key`. There is no
+        // early exit, so compilers are free to vectorize the loop.
+        template <typename Key, typename Compare, std::size_t B>
+        struct stree_rank {
+            static std::size_t rank(Key const* block, Key const& key) {
+                std::size_t count = 0;
+                for(std::size_t i = 0; i < B; ++i)
+                    count += static_cast<std::size_t>(Compare{}(block[i], key));
+                return count;
+            }
+        };
+
+#if defined(IMMUTABLE_FLAT_SSE2)
+        template <>
+        struct stree_rank<std::int32_t, std::less<std::int32_t>, 16> {
+            static std::size_t rank(std::int32_t const* block, std::int32_t key) {
+                auto const needle = _mm_set1_epi32(key);
+                auto const data = reinterpret_cast<__m128i const*>(block);
+
+                // lanes holding a smaller key compare to -1
+                auto sum = _mm_add_epi32(
+                    _mm_add_epi32(_mm_cmpgt_epi32(needle, _mm_load_si128(data + 0)),
+                                  _mm_cmpgt_epi32(needle, _mm_load_si128(data + 1))),
+                    _mm_add_epi32(_mm_cmpgt_epi32(needle, _mm_load_si128(data + 2)),
+                                  _mm_cmpgt_epi32(needle, _mm_load_si128(data + 3))));
+                sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+                sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+                return static_cast<std::size_t>(-_mm_cvtsi128_si32(sum));
+            }
+        };
+#endif
+
+        // A static B-tree over sorted keys. Every node is a block of B keys
+        // filling one cache line, and the B + 1 children of block k are the
+        // blocks k * (B + 1) + 1 ... k * (B + 1) + B + 1. A lookup touches one
+        // cache line per level and finds its way through a block by counting
+        // instead of branching. Slots beyond the number of keys hold copies
+        // of the largest key. They are the last slots in key order, which is
+        // not the last block: with 17 keys of 16 per block they are slots
+        // 1 to 15 of the root block. A copy of the largest key never sorts
+        // before a real key, so lookups still find the real slot first.
+        template <typename Key, typename Compare>
+        class stree {
+        public:
+            static constexpr std::size_t block_size = stree_block_size<Key>::value;
+
+            stree() = default;
+
+            stree(std::size_t size, Key const& padding)
+                : m_keys((size + block_size - 1) / block_size * block_size, padding)
+            {}
+
+            std::size_t slots() const { return m_keys.size(); }
+
+            Key const& key(std::size_t slot) const { return m_keys[slot]; }
+            Key& key(std::size_t slot) { return m_keys[slot]; }
+
+            // Calls `visit(slot)` for every slot, in key order.
+            template <typename Visit>
+            void for_each_slot(Visit&& visit) const {
+                for_each_slot(0, visit);
+            }
+
+            // The slot holding the first key not less than `key`, or slots().
+            std::size_t lower_bound(Key const& key) const {
+                auto result = slots();
+                auto const blocks = this->blocks();
+                std::size_t k = 0;
+                while(k < blocks) {
+                    auto const i = stree_rank<Key, Compare, block_size>::rank(&m_keys[k * block_size], key);
+                    if(i < block_size)
+                        result = k * block_size + i;
+                    k = child(k, i);
+                }
+                return result;
+            }
+
+            // The slot holding `key`, or slots().
+            std::size_t find(Key const& key) const {
+                auto const slot = lower_bound(key);
+                if(slot == slots() || Compare{}(key, m_keys[slot]))
+                    return slots();
+                return slot;
+            }
+
+        private:
+            // derived from the keys, so a moved-from tree is simply empty
+            std::size_t blocks() const {
+                return m_keys.size() / block_size;
+            }
+
+            static std::size_t child(std::size_t k, std::size_t i) {
+                return k * (block_size + 1) + i + 1;
+            }
+
+            template <typename Visit>
+            void for_each_slot(std::size_t k, Visit& visit) const {
+                if(k >= blocks())
+                    return;
+
+                for(std::size_t i = 0; i < block_size; ++i) {
+                    for_each_slot(child(k, i), visit);
+                    visit(k * block_size + i);
+                }
+                for_each_slot(child(k, block_size), visit);
+            }
+
+            std::vector<Key, cache_aligned_allocator<Key>> m_keys;
+        };
+    }
+
+
+    // An immutable sorted map that is built once from a range and then only
+    // read. Keys are stored in a static B-tree of cache line sized blocks
+    // (see `detail::stree`) and values in a parallel array, so a lookup costs
+    // about one cache miss per 17-fold growth of the map for 32 bit keys,
+    // where binary search over a sorted vector pays one per doubling.
+    // Of several entries with equivalent keys the first one is kept.
+    template <typename Key, typename Value, typename Compare = std::less<Key>>
+    class flat_sorted_map {
+    public:
+        using key_type = Key;
+        using mapped_type = Value;
+        using value_type = std::pair<Key, Value>;
+        using key_compare = Compare;
+
+        flat_sorted_map() = default;
+
+        template <typename InputIt>
+        flat_sorted_map(InputIt first, InputIt last) {
+            std::vector<value_type> entries(first, last);
+            std::stable_sort(entries.begin(), entries.end(), [](value_type const& a, value_type const& b) {
+                return Compare{}(a.first, b.first);
+            });
+            entries.erase(std::unique(entries.begin(), entries.end(), [](value_type const& a, value_type const& b) {
+                return !Compare{}(a.first, b.first);
+            }), entries.end());
+
+            if(entries.empty())
+                return;
+
+            m_size = entries.size();
+            m_index = detail::stree<Key, Compare>{ m_size, entries.back().first };
+            m_values = std::vector<Value>(m_index.slots(), entries.back().second);
+
+            std::size_t next = 0;
+            m_index.for_each_slot([&](std::size_t slot) {
+                if(next < entries.size()) {
+                    m_index.key(slot) = std::move(entries[next].first);
+                    m_values[slot] = std::move(entries[next].second);
+                }
+                ++next;
+            });
+        }
+
+        flat_sorted_map(std::initializer_list<value_type> entries)
+            : flat_sorted_map(entries.begin(), entries.end())
+        {}
+
+        flat_sorted_map(flat_sorted_map const& other) = default;
+        flat_sorted_map(flat_sorted_map&& other) noexcept
+            : m_size{ std::exchange(other.m_size, 0) }
+            , m_index{ std::move(other.m_index) }
+            , m_values{ std::move(other.m_values) }
+        {}
+
+        // make it immutable
+        flat_sorted_map& operator= (flat_sorted_map const& other) = delete;
+        flat_sorted_map& operator= (flat_sorted_map&& other) = delete;
+
+        std::size_t size() const { return m_size; }
+        bool empty() const { return m_size == 0; }
+
+        bool contains(Key const& key) const {
+            return m_index.find(key) != m_index.slots();
+        }
+
+        optional<Value> find(Key const& key) const {
+            auto const slot = m_index.find(key);
+            if(slot == m_index.slots())
+                return {};
+
+            return optional<Value>{m_values[slot]};
+        }
+
+        // The first entry whose key is not less than `key`.
+        optional<value_type> lower_bound(Key const& key) const {
+            auto const slot = m_index.lower_bound(key);
+            if(slot == m_index.slots())
+                return {};
+
+            return optional<value_type>{m_index.key(slot), m_values[slot]};
+        }
+
+    private:
+        std::size_t m_size = 0;
+        detail::stree<Key, Compare> m_index;
+        std::vector<Value> m_values;
+    };
+
+
+    // The set counterpart of `flat_sorted_map`.
+    template <typename Key, typename Compare = std::less<Key>>
+    class flat_sorted_set {
+    public:
+        using key_type = Key;
+        using value_type = Key;
+        using key_compare = Compare;
+
+        flat_sorted_set() = default;
+
+        template <typename InputIt>
+        flat_sorted_set(InputIt first, InputIt last) {
+            std::vector<Key> keys(first, last);
+            std::stable_sort(keys.begin(), keys.end(), Compare{});
+            keys.erase(std::unique(keys.begin(), keys.end(), [](Key const& a, Key const& b) {
+                return !Compare{}(a, b);
+            }), keys.end());
+
+            if(keys.empty())
+                return;
+
+            m_size = keys.size();
+            m_index = detail::stree<Key, Compare>{ m_size, keys.back() };
+
+            std::size_t next = 0;
+            m_index.for_each_slot([&](std::size_t slot) {
+                if(next < keys.size())
+                    m_index.key(slot) = std::move(keys[next]);
+                ++next;
+            });
+        }
+
+        flat_sorted_set(std::initializer_list<Key> keys)
+            : flat_sorted_set(keys.begin(), keys.end())
+        {}
+
+        flat_sorted_set(flat_sorted_set const& other) = default;
+        flat_sorted_set(flat_sorted_set&& other) noexcept
+            : m_size{ std::exchange(other.m_size, 0) }
+            , m_index{ std::move(other.m_index) }
+        {}
+
+        // make it immutable
+        flat_sorted_set& operator= (flat_sorted_set const& other) = delete;
+        flat_sorted_set& operator= (flat_sorted_set&& other) = delete;
+
+        std::size_t size() const { return m_size; }
+        bool empty() const { return m_size == 0; }
+
+        bool contains(Key const& key) const {
+            return m_index.find(key) != m_index.slots();
+        }
+
+        optional<Key> find(Key const& key) const {
+            auto const slot = m_index.find(key);
+            if(slot == m_index.slots())
+                return {};
+
+            return optional<Key>{m_index.key(slot)};
+        }
+
+        // The first key not less than `key`.
+        optional<Key> lower_bound(Key const& key) const {
+            auto const slot = m_index.lower_bound(key);
+            if(slot == m_index.slots())
+                return {};
+
+            return optional<Key>{m_index.key(slot)};
+        }
+
+    private:
+        std::size_t m_size = 0;
+        detail::stree<Key, Compare> m_index;
+    };
+
+}
@@ -0,0 +1 @@
+#include <immutable-flat/immutable-flat.h>
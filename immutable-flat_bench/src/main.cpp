@@ -0,0 +1,103 @@
+#include <immutable-flat/immutable-flat.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <random>
+#include <utility>
+#include <vector>
+
+// Compares lookups in imm::flat_sorted_map against std::lower_bound on a
+// sorted std::vector and against std::map, for 1K up to 100M 32 bit keys.
+// The keys are the even numbers 0, 2, 4, ... and the lookups are random
+// numbers below twice the key count, so about half of them hit. Usage:
+//
+//     immutable-flat_bench [max-keys [std::map-max-keys]]
+//
+// std::map needs about 50 bytes per key, so by default it is only measured
+// up to 10M keys.
+
+namespace {
+
+    using clock = std::chrono::steady_clock;
+
+    static constexpr std::size_t lookups = 1 << 22;
+
+    // keeps the lookups from being optimized away
+    volatile std::size_t sink;
+
+    template <typename Lookup>
+    double nanoseconds_per_lookup(std::vector<std::int32_t> const& queries, Lookup lookup) {
+        std::size_t hits = 0;
+        auto const start = clock::now();
+        for(auto const query : queries)
+            hits += lookup(query);
+        auto const stop = clock::now();
+
+        sink = hits;
+
+        return std::chrono::duration<double, std::nano>(stop - start).count() / queries.size();
+    }
+
+    void report(char const* name, double ns) {
+        std::cout << "  " << std::left << std::setw(20) << name
+                  << std::right << std::fixed << std::setprecision(1) << std::setw(8) << ns << " ns/lookup\n";
+    }
+
+    void run(std::size_t size, std::size_t map_limit, std::mt19937& random) {
+        // even keys are present, odd keys are misses
+        std::vector<std::int32_t> keys(size);
+        for(std::size_t i = 0; i < size; ++i)
+            keys[i] = static_cast<std::int32_t>(2 * i);
+
+        std::vector<std::int32_t> queries(lookups);
+        std::uniform_int_distribution<std::int32_t> pick{ 0, static_cast<std::int32_t>(2 * size - 1) };
+        for(auto& query : queries)
+            query = pick(random);
+
+        std::cout << size << " keys\n";
+
+        {
+            auto const& sorted = keys;
+            report("std::lower_bound", nanoseconds_per_lookup(queries, [&](std::int32_t key) {
+                auto const it = std::lower_bound(sorted.begin(), sorted.end(), key);
+                return it != sorted.end() && *it == key;
+            }));
+        }
+
+        {
+            std::vector<std::pair<std::int32_t, std::int32_t>> entries;
+            entries.reserve(size);
+            for(auto const key : keys)
+                entries.emplace_back(key, key);
+
+            imm::flat_sorted_map<std::int32_t, std::int32_t> const map(entries.begin(), entries.end());
+            report("imm::flat_sorted_map", nanoseconds_per_lookup(queries, [&](std::int32_t key) {
+                return map.find(key) != imm::nothing;
+            }));
+        }
+
+        if(size <= map_limit) {
+            std::map<std::int32_t, std::int32_t> map;
+            for(auto const key : keys)
+                map.emplace_hint(map.end(), key, key);
+
+            report("std::map", nanoseconds_per_lookup(queries, [&](std::int32_t key) {
+                return map.find(key) != map.end();
+            }));
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::size_t const max_size = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000000;
+    std::size_t const map_limit = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 10000000;
+
+    std::mt19937 random{42};
+    for(std::size_t size = 1000; size <= max_size; size *= 10)
+        run(size, map_limit, random);
+}
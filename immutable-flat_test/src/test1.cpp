@@ -0,0 +1,168 @@
+#include <catch.hpp>
+#include <immutable-flat/immutable-flat.h>
+#include <functional>
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace imm;
+
+TEST_CASE("flat_sorted_map default", "[flat-map]") {
+    GIVEN("a default-initialized flat_sorted_map") {
+        flat_sorted_map<int, int> map;
+        THEN("it is empty and finds nothing") {
+            CHECK(map.empty());
+            CHECK(map.size() == 0);
+            CHECK(map.find(42) == nothing);
+            REQUIRE(map.lower_bound(42) == nothing);
+        }
+    }
+}
+
+TEST_CASE("flat_sorted_map construction", "[flat-map]") {
+    GIVEN("a flat_sorted_map built from an initializer list") {
+        flat_sorted_map<int, std::string> map{ { 3, "three" }, { 1, "one" }, { 2, "two" } };
+        THEN("every entry is found") {
+            CHECK(map.size() == 3);
+            CHECK(*map.find(1) == "one");
+            CHECK(*map.find(2) == "two");
+            REQUIRE(*map.find(3) == "three");
+        }
+        THEN("keys that were not given are not found") {
+            CHECK(map.find(0) == nothing);
+            CHECK(!map.contains(4));
+            REQUIRE(map.find(4) == nothing);
+        }
+    }
+}
+
+TEST_CASE("flat_sorted_map keeps the first of equivalent keys", "[flat-map]") {
+    GIVEN("entries with repeated keys") {
+        std::vector<std::pair<int, int>> const entries{ { 1, 10 }, { 2, 20 }, { 1, 11 }, { 2, 21 } };
+        flat_sorted_map<int, int> map(entries.begin(), entries.end());
+        THEN("like std::map::insert, the first entry wins") {
+            CHECK(map.size() == 2);
+            CHECK(*map.find(1) == 10);
+            REQUIRE(*map.find(2) == 20);
+        }
+    }
+}
+
+TEST_CASE("flat_sorted_map agrees with std::map", "[flat-map]") {
+    std::mt19937 random{42};
+
+    // around and across the block boundaries of a two- and three-level tree
+    for(std::size_t size : { 1, 2, 15, 16, 17, 33, 271, 272, 273, 1000, 5000, 20000 }) {
+        std::map<int, int> reference;
+        std::uniform_int_distribution<int> keys{ -3 * static_cast<int>(size), 3 * static_cast<int>(size) };
+        while(reference.size() < size)
+            reference.emplace(keys(random), static_cast<int>(reference.size()));
+
+        flat_sorted_map<int, int> map(reference.begin(), reference.end());
+        REQUIRE(map.size() == reference.size());
+
+        for(int key = keys.min() - 1; key <= keys.max() + 1; ++key) {
+            auto const expected = reference.lower_bound(key);
+            auto const found = map.lower_bound(key);
+            if(expected == reference.end()) {
+                REQUIRE(found == nothing);
+                REQUIRE(map.find(key) == nothing);
+            }
+            else {
+                REQUIRE(found != nothing);
+                REQUIRE((*found).first == expected->first);
+                REQUIRE((*found).second == expected->second);
+                REQUIRE(map.contains(key) == (expected->first == key));
+            }
+        }
+    }
+}
+
+TEST_CASE("flat_sorted_map with a custom order", "[flat-map]") {
+    GIVEN("a flat_sorted_map ordered by std::greater") {
+        flat_sorted_map<long long, int, std::greater<long long>> map{ { 10, 1 }, { 30, 3 }, { 20, 2 } };
+        THEN("lower_bound follows that order") {
+            CHECK((*map.lower_bound(25)).first == 20);
+            CHECK((*map.lower_bound(40)).first == 30);
+            REQUIRE(map.lower_bound(5) == nothing);
+        }
+    }
+}
+
+TEST_CASE("flat_sorted_map copy constructor", "[flat-map]") {
+    GIVEN("a flat_sorted_map") {
+        flat_sorted_map<int, int> orig{ { 1, 1 }, { 2, 4 } };
+        WHEN("a copy is constructed") {
+            auto copy{orig};
+            THEN("the copy finds the same entries") {
+                CHECK(*copy.find(1) == 1);
+                REQUIRE(*copy.find(2) == 4);
+            }
+        }
+    }
+}
+
+TEST_CASE("flat_sorted_map move constructor", "[flat-map]") {
+    GIVEN("a flat_sorted_map") {
+        flat_sorted_map<int, int> orig{ { 1, 1 }, { 2, 4 }, { 3, 9 } };
+        WHEN("a copy is move-constructed") {
+            auto move_copy{std::move(orig)};
+            THEN("the copy has the entries and the original is empty") {
+                CHECK(move_copy.size() == 3);
+                CHECK(*move_copy.find(2) == 4);
+                CHECK(orig.size() == 0);
+                CHECK(orig.empty());
+                CHECK(!orig.contains(2));
+                CHECK(orig.find(2) == nothing);
+                REQUIRE(orig.lower_bound(0) == nothing);
+            }
+        }
+    }
+}
+
+TEST_CASE("flat_sorted_set move constructor", "[flat-set]") {
+    GIVEN("a flat_sorted_set") {
+        flat_sorted_set<int> orig{ 1, 2, 3 };
+        WHEN("a copy is move-constructed") {
+            auto move_copy{std::move(orig)};
+            THEN("the copy has the keys and the original is empty") {
+                CHECK(move_copy.size() == 3);
+                CHECK(move_copy.contains(2));
+                CHECK(orig.size() == 0);
+                CHECK(!orig.contains(2));
+                REQUIRE(orig.find(2) == nothing);
+            }
+        }
+    }
+}
+
+TEST_CASE("flat_sorted_set agrees with std::set", "[flat-set]") {
+    std::mt19937 random{7};
+    std::uniform_int_distribution<int> letters{ 'a', 'e' };
+
+    std::set<std::string> reference;
+    std::vector<std::string> words;
+    for(int i = 0; i < 2000; ++i) {
+        std::string word(1 + i % 4, 'a');
+        for(auto& c : word)
+            c = static_cast<char>(letters(random));
+        words.push_back(word);
+        reference.insert(word);
+    }
+
+    flat_sorted_set<std::string> set(words.begin(), words.end());
+    REQUIRE(set.size() == reference.size());
+
+    for(auto const& word : { std::string{}, std::string{"a"}, std::string{"abc"}, std::string{"cc"},
+                             std::string{"eeee"}, std::string{"eeeee"}, std::string{"f"} }) {
+        auto const expected = reference.lower_bound(word);
+        auto const found = set.lower_bound(word);
+        if(expected == reference.end())
+            REQUIRE(found == nothing);
+        else
+            REQUIRE(*found == *expected);
+        REQUIRE(set.contains(word) == (reference.count(word) == 1));
+    }
+}
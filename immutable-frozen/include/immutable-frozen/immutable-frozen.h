@@ -0,0 +1,195 @@
+#pragma once
+#include <immutable-frozen/export.h>
+#include <immutable-optional/immutable-optional.h>
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+
+namespace imm {
+
+    // Orders C strings by their contents, so that `char const*` keys can be
+    // sorted while the table is being built by the compiler.
+    struct frozen_cstring_less {
+        constexpr bool operator()(char const* a, char const* b) const {
+            while(*a != '\0' && *a == *b) {
+                ++a;
+                ++b;
+            }
+            return static_cast<unsigned char>(*a) < static_cast<unsigned char>(*b);
+        }
+    };
+
+    namespace detail {
+
+        struct select_self {
+            template <typename T>
+            constexpr T const& operator()(T const& value) const { return value; }
+        };
+
+        struct select_first {
+            template <typename Pair>
+            constexpr auto const& operator()(Pair const& pair) const { return pair.first; }
+        };
+
+        // `index[k]` is the input entry that ends up in slot `k` of the frozen
+        // table. Slots are in eytzinger (breadth-first) order: the children of
+        // slot `k - 1` are the slots `2k - 1` and `2k`.
+        template <std::size_t N>
+        struct eytzinger_order {
+            std::size_t index[N];
+        };
+
+        template <std::size_t N>
+        constexpr std::size_t eytzinger_fill(std::size_t const (&sorted)[N], eytzinger_order<N>& order, std::size_t i, std::size_t k) {
+            if(k <= N) {
+                i = eytzinger_fill(sorted, order, i, 2 * k);
+                order.index[k - 1] = sorted[i++];
+                i = eytzinger_fill(sorted, order, i, 2 * k + 1);
+            }
+            return i;
+        }
+
+        template <typename Compare, typename Project, typename Entry, std::size_t N>
+        constexpr eytzinger_order<N> make_eytzinger_order(Entry const (&entries)[N]) {
+            std::size_t sorted[N] {};
+            for(std::size_t i = 0; i < N; ++i)
+                sorted[i] = i;
+
+            // insertion sort: tables are small and this runs in the compiler
+            for(std::size_t i = 1; i < N; ++i) {
+                auto const current = sorted[i];
+                auto j = i;
+                for(; j > 0 && Compare{}(Project{}(entries[current]), Project{}(entries[sorted[j - 1]])); --j)
+                    sorted[j] = sorted[j - 1];
+                sorted[j] = current;
+            }
+
+            for(std::size_t i = 1; i < N; ++i) {
+                if(!Compare{}(Project{}(entries[sorted[i - 1]]), Project{}(entries[sorted[i]])))
+                    throw std::invalid_argument("imm::frozen: duplicate key");
+            }
+
+            eytzinger_order<N> order {};
+            eytzinger_fill(sorted, order, 0, 1);
+            return order;
+        }
+
+        // Branch-free descent through the eytzinger layout. Returns the slot
+        // holding `key`, or N if there is none.
+        template <typename Compare, typename Key, std::size_t N>
+        constexpr std::size_t eytzinger_find(Key const (&keys)[N], Key const& key) {
+            std::size_t k = 1;
+            while(k <= N)
+                k = 2 * k + static_cast<std::size_t>(Compare{}(keys[k - 1], key));
+
+            // undo the trailing right turns and the final left turn to get back
+            // to the lower bound
+            while(k & 1)
+                k >>= 1;
+            k >>= 1;
+
+            if(k == 0 || Compare{}(key, keys[k - 1]))
+                return N;
+            return k - 1;
+        }
+    }
+
+
+    // A set whose contents are fixed at compile time. The keys are sorted and
+    // laid out in eytzinger order while the compiler evaluates the constructor,
+    // so a `constexpr` instance lives in read-only data: it needs no static
+    // initialization and never allocates.
+    template <typename Key, std::size_t N, typename Compare = std::less<Key>>
+    class frozen_set {
+        static_assert(N > 0, "imm::frozen_set needs at least one key");
+
+    public:
+        using key_type = Key;
+        using key_compare = Compare;
+
+        constexpr frozen_set(Key const (&keys)[N])
+            : frozen_set(keys,
+                         detail::make_eytzinger_order<Compare, detail::select_self>(keys),
+                         std::make_index_sequence<N>{})
+        {}
+
+        constexpr std::size_t size() const { return N; }
+
+        constexpr bool contains(Key const& key) const {
+            return detail::eytzinger_find<Compare>(m_keys, key) != N;
+        }
+
+        optional<Key> find(Key const& key) const {
+            auto const slot = detail::eytzinger_find<Compare>(m_keys, key);
+            if(slot == N)
+                return {};
+
+            return optional<Key>{m_keys[slot]};
+        }
+
+    private:
+        template <std::size_t...I>
+        constexpr frozen_set(Key const (&keys)[N], detail::eytzinger_order<N> const& order, std::index_sequence<I...>)
+            : m_keys{ keys[order.index[I]]... }
+        {}
+
+        Key m_keys[N];
+    };
+
+
+    // A map whose contents are fixed at compile time; see `frozen_set`. Keys
+    // and values are kept in separate arrays so that a lookup only touches the
+    // value it returns.
+    template <typename Key, typename Value, std::size_t N, typename Compare = std::less<Key>>
+    class frozen_map {
+        static_assert(N > 0, "imm::frozen_map needs at least one entry");
+
+    public:
+        using key_type = Key;
+        using mapped_type = Value;
+        using key_compare = Compare;
+
+        constexpr frozen_map(std::pair<Key, Value> const (&entries)[N])
+            : frozen_map(entries,
+                         detail::make_eytzinger_order<Compare, detail::select_first>(entries),
+                         std::make_index_sequence<N>{})
+        {}
+
+        constexpr std::size_t size() const { return N; }
+
+        constexpr bool contains(Key const& key) const {
+            return detail::eytzinger_find<Compare>(m_keys, key) != N;
+        }
+
+        optional<Value> find(Key const& key) const {
+            auto const slot = detail::eytzinger_find<Compare>(m_keys, key);
+            if(slot == N)
+                return {};
+
+            return optional<Value>{m_values[slot]};
+        }
+
+    private:
+        template <std::size_t...I>
+        constexpr frozen_map(std::pair<Key, Value> const (&entries)[N], detail::eytzinger_order<N> const& order, std::index_sequence<I...>)
+            : m_keys{ entries[order.index[I]].first... }
+            , m_values{ entries[order.index[I]].second... }
+        {}
+
+        Key m_keys[N];
+        Value m_values[N];
+    };
+
+
+    template <typename Key, typename Compare = std::less<Key>, std::size_t N>
+    constexpr frozen_set<Key, N, Compare> make_frozen_set(Key const (&keys)[N]) {
+        return { keys };
+    }
+
+    template <typename Key, typename Value, typename Compare = std::less<Key>, std::size_t N>
+    constexpr frozen_map<Key, Value, N, Compare> make_frozen_map(std::pair<Key, Value> const (&entries)[N]) {
+        return { entries };
+    }
+
+}
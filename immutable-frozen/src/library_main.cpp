@@ -0,0 +1 @@
+#include <immutable-frozen/immutable-frozen.h>
@@ -0,0 +1,106 @@
+#include <catch.hpp>
+#include <immutable-frozen/immutable-frozen.h>
+#include <string>
+
+using namespace imm;
+
+namespace {
+    enum class color { red, green, blue, black };
+
+    constexpr auto color_names = make_frozen_map<color, char const*>({
+        { color::blue,  "blue"  },
+        { color::red,   "red"   },
+        { color::green, "green" },
+    });
+
+    constexpr auto field_ids = make_frozen_map<char const*, int, frozen_cstring_less>({
+        { "length",   3 },
+        { "checksum", 7 },
+        { "id",       1 },
+        { "payload",  4 },
+        { "flags",    2 },
+    });
+
+    constexpr auto primes = make_frozen_set<int>({ 13, 2, 7, 3, 11, 5, 17, 19, 23, 29 });
+
+    static_assert(color_names.size() == 3, "size is known at compile time");
+    static_assert(color_names.contains(color::green), "lookups can be evaluated at compile time");
+    static_assert(!color_names.contains(color::black), "lookups can be evaluated at compile time");
+    static_assert(field_ids.contains("payload"), "string keys are compared by contents");
+    static_assert(primes.contains(23) && !primes.contains(24), "sets can be queried at compile time");
+}
+
+TEST_CASE("frozen_map finds every key it was built from", "[frozen-map]") {
+    GIVEN("a frozen map from an enum to its names") {
+        THEN("each key maps to its name") {
+            CHECK(std::string{*color_names.find(color::red)} == "red");
+            CHECK(std::string{*color_names.find(color::green)} == "green");
+            REQUIRE(std::string{*color_names.find(color::blue)} == "blue");
+        }
+    }
+}
+
+TEST_CASE("frozen_map misses unknown keys", "[frozen-map]") {
+    GIVEN("a frozen map from an enum to its names") {
+        THEN("a key that was not given is not found") {
+            CHECK(!color_names.contains(color::black));
+            REQUIRE(color_names.find(color::black) == nothing);
+        }
+    }
+}
+
+TEST_CASE("frozen_map with string keys", "[frozen-map]") {
+    GIVEN("a frozen map from field names to ids") {
+        THEN("keys are looked up by contents, not by address") {
+            std::string const name = "checksum";
+            CHECK(*field_ids.find(name.c_str()) == 7);
+            CHECK(*field_ids.find("id") == 1);
+            CHECK(field_ids.find("i") == nothing);
+            REQUIRE(field_ids.find("identifier") == nothing);
+        }
+    }
+}
+
+TEST_CASE("frozen_set membership", "[frozen-set]") {
+    GIVEN("a frozen set of primes") {
+        THEN("every prime given is found, every other number is not") {
+            for(int i = -1; i < 32; ++i) {
+                bool const is_prime = i == 2 || i == 3 || i == 5 || i == 7 || i == 11 || i == 13
+                                   || i == 17 || i == 19 || i == 23 || i == 29;
+                CHECK(primes.contains(i) == is_prime);
+                CHECK((primes.find(i) != nothing) == is_prime);
+            }
+        }
+    }
+}
+
+TEST_CASE("frozen tables of every size", "[frozen-set]") {
+    GIVEN("frozen sets whose size is not a full tree") {
+        constexpr auto one = make_frozen_set<int>({ 4 });
+        constexpr auto two = make_frozen_set<int>({ 8, 4 });
+        constexpr auto six = make_frozen_set<int>({ 24, 4, 16, 8, 20, 12 });
+
+        THEN("lookups below, between and above the keys behave") {
+            CHECK(one.contains(4));
+            CHECK(!one.contains(3));
+            CHECK(!one.contains(5));
+            CHECK(two.contains(4));
+            CHECK(two.contains(8));
+            CHECK(!two.contains(6));
+            CHECK(!two.contains(9));
+            for(int i = 0; i <= 28; ++i)
+                CHECK(six.contains(i) == (i > 0 && i % 4 == 0 && i <= 24));
+            REQUIRE(*six.find(12) == 12);
+        }
+    }
+}
+
+TEST_CASE("frozen_map rejects duplicate keys", "[frozen-map]") {
+    GIVEN("entries with a repeated key") {
+        std::pair<int, int> const entries[] = { { 1, 1 }, { 2, 2 }, { 1, 3 } };
+
+        THEN("building the table outside a constant expression throws") {
+            REQUIRE_THROWS_AS((frozen_map<int, int, 3>{ entries }), std::invalid_argument);
+        }
+    }
+}
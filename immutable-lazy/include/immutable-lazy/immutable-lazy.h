@@ -0,0 +1,265 @@
+#pragma once
+#include <immutable-lazy/export.h>
+#include <immutable-optional/immutable-optional.h>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace imm {
+
+    // A lazily evaluated sequence, produced by a coroutine that `co_yield`s
+    // its elements one at a time:
+    //
+    //     imm::lazy_seq<int> naturals() {
+    //         for(int i = 0;; ++i)
+    //             co_yield i;
+    //     }
+    //
+    // Nothing runs until the first element is asked for. `map`, `filter` and
+    // `take` wrap the sequence into another lazy one, and `into` feeds all
+    // elements to a builder, so a streamed result never needs a temporary
+    // container. A sequence can be walked once, either with `next`, with
+    // begin()/end() or with `into`.
+    template <typename T>
+    class lazy_seq {
+    public:
+        using value_type = T;
+
+        struct promise_type {
+            lazy_seq get_return_object() {
+                return lazy_seq{ std::coroutine_handle<promise_type>::from_promise(*this) };
+            }
+
+            std::suspend_always initial_suspend() noexcept { return {}; }
+            std::suspend_always final_suspend() noexcept { return {}; }
+
+            // The yielded object outlives the suspension, so only its address
+            // is kept. Temporaries may be moved from, everything else is copied.
+            std::suspend_always yield_value(T const& value) noexcept
+                requires std::is_copy_constructible_v<T>
+            {
+                m_current = std::addressof(value);
+                m_movable = nullptr;
+                return {};
+            }
+
+            std::suspend_always yield_value(T&& value) noexcept {
+                m_current = std::addressof(value);
+                m_movable = std::addressof(value);
+                return {};
+            }
+
+            void return_void() noexcept {}
+
+            void unhandled_exception() noexcept {
+                m_exception = std::current_exception();
+            }
+
+            // lazy sequences are synchronous
+            template <typename U>
+            std::suspend_never await_transform(U&&) = delete;
+
+            T take() {
+                if constexpr(std::is_copy_constructible_v<T>) {
+                    if(m_movable == nullptr)
+                        return *m_current;
+                }
+                return std::move(*m_movable);
+            }
+
+            T const* m_current = nullptr;
+            T* m_movable = nullptr;
+            std::exception_ptr m_exception;
+        };
+
+        class iterator {
+        public:
+            using iterator_category = std::input_iterator_tag;
+            using difference_type = std::ptrdiff_t;
+            using value_type = T;
+            using pointer = T const*;
+            using reference = T const&;
+
+            iterator() = default;
+
+            reference operator* () const { return *m_seq->m_handle.promise().m_current; }
+            pointer operator-> () const { return m_seq->m_handle.promise().m_current; }
+
+            iterator& operator++ () {
+                if(!m_seq->advance())
+                    m_seq = nullptr;
+                return *this;
+            }
+
+            // Holds the element an iterator pointed at before `it++`, which
+            // the sequence has already moved past, so that `*it++` works.
+            class postfix_proxy {
+            public:
+                reference operator* () const { return m_value; }
+
+            private:
+                friend class iterator;
+
+                explicit postfix_proxy(T const& value)
+                    : m_value{value}
+                {}
+
+                T m_value;
+            };
+
+            postfix_proxy operator++ (int)
+                requires std::is_copy_constructible_v<T>
+            {
+                postfix_proxy previous{ **this };
+                ++*this;
+                return previous;
+            }
+
+            // a move-only element cannot be kept behind, so only range-for
+            // and prefix increments work for those
+            void operator++ (int)
+                requires (!std::is_copy_constructible_v<T>)
+            {
+                ++*this;
+            }
+
+            friend bool operator == (iterator const& a, iterator const& b) { return a.m_seq == b.m_seq; }
+            friend bool operator != (iterator const& a, iterator const& b) { return a.m_seq != b.m_seq; }
+
+        private:
+            friend class lazy_seq;
+
+            explicit iterator(lazy_seq* seq)
+                : m_seq{seq}
+            {}
+
+            lazy_seq* m_seq = nullptr;
+        };
+
+        lazy_seq(lazy_seq&& other) noexcept
+            : m_handle{ std::exchange(other.m_handle, nullptr) }
+        {}
+
+        // A sequence owns its coroutine and can be walked only once, so it
+        // can be moved but neither copied nor assigned.
+        lazy_seq(lazy_seq const& other) = delete;
+        lazy_seq& operator= (lazy_seq const& other) = delete;
+        lazy_seq& operator= (lazy_seq&& other) = delete;
+
+        ~lazy_seq() {
+            if(m_handle)
+                m_handle.destroy();
+        }
+
+        // The next element, or nothing once the sequence is exhausted.
+        optional<T> next() {
+            if(!advance())
+                return {};
+
+            return optional<T>{ m_handle.promise().take() };
+        }
+
+        iterator begin() {
+            return advance() ? iterator{this} : iterator{};
+        }
+
+        iterator end() { return {}; }
+
+        // Passes every remaining element to `builder.push_back` and returns the
+        // builder, e.g. the batch builder of an immutable container.
+        template <typename Builder>
+        Builder into(Builder builder) && {
+            while(advance())
+                builder.push_back(m_handle.promise().take());
+            return builder;
+        }
+
+        template <typename F>
+        lazy_seq<std::decay_t<std::invoke_result_t<F&, T>>> map(F f) &&;
+
+        template <typename Predicate>
+        lazy_seq filter(Predicate predicate) &&;
+
+        lazy_seq take(std::size_t count) &&;
+
+    private:
+        explicit lazy_seq(std::coroutine_handle<promise_type> handle)
+            : m_handle{handle}
+        {}
+
+        // Runs the coroutine up to its next element; false once it is done.
+        bool advance() {
+            if(!m_handle || m_handle.done())
+                return false;
+
+            m_handle.resume();
+            if(m_handle.done()) {
+                if(auto exception = std::exchange(m_handle.promise().m_exception, nullptr))
+                    std::rethrow_exception(exception);
+                return false;
+            }
+            return true;
+        }
+
+        std::coroutine_handle<promise_type> m_handle;
+    };
+
+
+    namespace detail {
+
+        template <typename U, typename T, typename F>
+        lazy_seq<U> lazy_map(lazy_seq<T> source, F f) {
+            for(;;) {
+                auto value = source.next();
+                if(value == nothing)
+                    co_return;
+                co_yield f(std::move(value).get());
+            }
+        }
+
+        template <typename T, typename Predicate>
+        lazy_seq<T> lazy_filter(lazy_seq<T> source, Predicate predicate) {
+            for(;;) {
+                auto value = source.next();
+                if(value == nothing)
+                    co_return;
+                if(predicate(value.get()))
+                    co_yield std::move(value).get();
+            }
+        }
+
+        template <typename T>
+        lazy_seq<T> lazy_take(lazy_seq<T> source, std::size_t count) {
+            // never pulls more than `count` elements from the source
+            for(; count > 0; --count) {
+                auto value = source.next();
+                if(value == nothing)
+                    co_return;
+                co_yield std::move(value).get();
+            }
+        }
+    }
+
+
+    template <typename T>
+    template <typename F>
+    lazy_seq<std::decay_t<std::invoke_result_t<F&, T>>> lazy_seq<T>::map(F f) && {
+        return detail::lazy_map<std::decay_t<std::invoke_result_t<F&, T>>>(std::move(*this), std::move(f));
+    }
+
+    template <typename T>
+    template <typename Predicate>
+    lazy_seq<T> lazy_seq<T>::filter(Predicate predicate) && {
+        return detail::lazy_filter(std::move(*this), std::move(predicate));
+    }
+
+    template <typename T>
+    lazy_seq<T> lazy_seq<T>::take(std::size_t count) && {
+        return detail::lazy_take(std::move(*this), count);
+    }
+
+}
@@ -0,0 +1 @@
+#include <immutable-lazy/immutable-lazy.h>
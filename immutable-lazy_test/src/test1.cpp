@@ -0,0 +1,152 @@
+#include <catch.hpp>
+#include <immutable-lazy/immutable-lazy.h>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace imm;
+
+namespace {
+    lazy_seq<int> naturals(int* produced = nullptr) {
+        for(int i = 0;; ++i) {
+            if(produced != nullptr)
+                *produced = i + 1;
+            co_yield i;
+        }
+    }
+
+    lazy_seq<int> range(int first, int last) {
+        for(int i = first; i < last; ++i)
+            co_yield i;
+    }
+
+    lazy_seq<int> failing() {
+        co_yield 1;
+        throw std::runtime_error("failing");
+    }
+
+    // stands in for the batch builder of an immutable container
+    template <typename T>
+    struct counting_builder {
+        std::vector<T> items;
+        std::size_t copies = 0;
+
+        void push_back(T const& item) {
+            ++copies;
+            items.push_back(item);
+        }
+
+        void push_back(T&& item) {
+            items.push_back(std::move(item));
+        }
+    };
+}
+
+TEST_CASE("lazy_seq next", "[lazy-seq]") {
+    GIVEN("a finite sequence") {
+        auto seq = range(0, 3);
+        THEN("next returns each element and then nothing") {
+            CHECK(*seq.next() == 0);
+            CHECK(*seq.next() == 1);
+            CHECK(*seq.next() == 2);
+            CHECK(seq.next() == nothing);
+            REQUIRE(seq.next() == nothing);
+        }
+    }
+}
+
+TEST_CASE("lazy_seq is lazy", "[lazy-seq]") {
+    GIVEN("an infinite sequence") {
+        int produced = 0;
+        auto seq = naturals(&produced);
+        THEN("nothing is produced before it is asked for") {
+            REQUIRE(produced == 0);
+        }
+        WHEN("two elements are taken") {
+            seq.next();
+            seq.next();
+            THEN("exactly two are produced") {
+                REQUIRE(produced == 2);
+            }
+        }
+    }
+}
+
+TEST_CASE("lazy_seq iteration", "[lazy-seq]") {
+    GIVEN("a finite sequence") {
+        THEN("it can be walked with a range-based for") {
+            std::vector<int> seen;
+            for(auto i : range(3, 7))
+                seen.push_back(i);
+            REQUIRE(seen == std::vector<int>{ 3, 4, 5, 6 });
+        }
+        THEN("it can be walked with generic input iterator code") {
+            auto seq = range(3, 7);
+            auto it = seq.begin();
+            CHECK(*it++ == 3);
+            CHECK(*it == 4);
+            REQUIRE(std::vector<int>(it, seq.end()) == std::vector<int>{ 4, 5, 6 });
+        }
+        THEN("an empty sequence begins at its end") {
+            auto seq = range(0, 0);
+            REQUIRE(seq.begin() == seq.end());
+        }
+    }
+}
+
+TEST_CASE("lazy_seq adaptors", "[lazy-seq]") {
+    GIVEN("an infinite sequence") {
+        int produced = 0;
+        WHEN("it is filtered, mapped and taken") {
+            auto seq = naturals(&produced)
+                .filter([](int i) { return i % 2 == 0; })
+                .map([](int i) { return std::to_string(i * i); })
+                .take(4);
+
+            THEN("the adapted elements come out in order") {
+                auto const result = std::move(seq).into(counting_builder<std::string>{});
+                REQUIRE(result.items == std::vector<std::string>{ "0", "4", "16", "36" });
+            }
+            THEN("only the elements needed are produced") {
+                std::move(seq).into(counting_builder<std::string>{});
+                REQUIRE(produced == 7);
+            }
+        }
+    }
+}
+
+TEST_CASE("lazy_seq into a builder", "[lazy-seq]") {
+    GIVEN("a sequence of mapped elements") {
+        auto seq = range(0, 100).map([](int i) { return std::string(static_cast<std::size_t>(i), 'x'); });
+        WHEN("it is materialized into a builder") {
+            auto const result = std::move(seq).into(counting_builder<std::string>{});
+            THEN("every element arrives, moved rather than copied") {
+                CHECK(result.items.size() == 100);
+                CHECK(result.items[42].size() == 42);
+                REQUIRE(result.copies == 0);
+            }
+        }
+    }
+}
+
+TEST_CASE("lazy_seq with move-only elements", "[lazy-seq]") {
+    GIVEN("a sequence of unique_ptr") {
+        auto seq = range(0, 3).map([](int i) { return std::make_unique<int>(i); });
+        THEN("elements can be taken with next") {
+            CHECK(**seq.next() == 0);
+            CHECK(**seq.next() == 1);
+            REQUIRE(**seq.next() == 2);
+        }
+    }
+}
+
+TEST_CASE("lazy_seq propagates exceptions", "[lazy-seq]") {
+    GIVEN("a sequence that throws after its first element") {
+        auto seq = failing().map([](int i) { return i + 1; });
+        THEN("the exception reaches the consumer") {
+            CHECK(*seq.next() == 2);
+            REQUIRE_THROWS_AS(seq.next(), std::runtime_error);
+        }
+    }
+}
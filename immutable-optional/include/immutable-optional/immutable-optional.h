@@ -1,3 +1,4 @@
+#pragma once
 #include <immutable-optional/export.h>
 #include <memory>
 #include <type_traits>
@@ -56,12 +57,15 @@ namespace imm {
             using std::swap;
             swap(m_empty, other.m_empty);
 
-            if(!m_empty)
+            if(!m_empty) {
                 new (&m_value) T(std::move(other.value()));
+                other.value().~T();
+            }
         }
 
         ~optional() noexcept(std::is_nothrow_destructible<T>::value) {
-            value().~T();
+            if(!m_empty)
+                value().~T();
         }
 
         optional& operator= (optional const& other) = delete;
@@ -251,3 +251,47 @@ TEST_CASE("optional move from temporary", "[optional-move]") {
         }
     }
 }
+
+
+namespace {
+    struct counts_destructions {
+        static int destructed;
+
+        counts_destructions() = default;
+        counts_destructions(counts_destructions&&) = default;
+
+        ~counts_destructions() {
+            ++destructed;
+        }
+    };
+
+    int counts_destructions::destructed = 0;
+}
+
+TEST_CASE("optional empty destructor", "[optional-destruct]") {
+    WHEN("an empty optional goes out of scope") {
+        counts_destructions::destructed = 0;
+        {
+            optional<counts_destructions> opt;
+        }
+
+        THEN("no destructor is called") {
+            REQUIRE(counts_destructions::destructed == 0);
+        }
+    }
+
+    WHEN("an optional is moved from") {
+        int destructed_by_move = 0;
+        {
+            optional<counts_destructions> orig{counts_destructions{}};
+            counts_destructions::destructed = 0;
+            auto move_copy{std::move(orig)};
+            destructed_by_move = counts_destructions::destructed;
+        }
+
+        THEN("the moved-from value is destroyed by the move, not by the emptied optional") {
+            CHECK(destructed_by_move == 1);
+            REQUIRE(counts_destructions::destructed == 2);
+        }
+    }
+}
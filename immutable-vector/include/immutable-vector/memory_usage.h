@@ -0,0 +1,220 @@
+#pragma once
+#include <immutable-vector/export.h>
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace imm {
+
+    // Describes a node type to `measure_memory`. Specialize it for the node
+    // type of a persistent container:
+    //
+    //     template <>
+    //     struct memory_node_traits<my_node> {
+    //         // bytes owned by the node itself, children excluded
+    //         static std::size_t bytes(my_node const& node);
+    //         // number of element or child slots, and how many are in use
+    //         static std::size_t capacity(my_node const& node);
+    //         static std::size_t size(my_node const& node);
+    //         // calls `visit(my_node const*)` for each child
+    //         template <typename Visit>
+    //         static void for_each_child(my_node const& node, Visit&& visit);
+    //     };
+    //
+    // Each version is expected to be a tree; nodes may only be shared between
+    // versions.
+    template <typename Node>
+    struct memory_node_traits;
+
+
+    struct memory_usage {
+        struct root_usage {
+            std::size_t nodes = 0;          // nodes reachable from this root
+            std::size_t bytes = 0;          // bytes reachable from this root
+            std::size_t unique_bytes = 0;   // ... that no other root reaches
+            std::size_t shared_bytes = 0;   // ... that another root reaches too
+            std::size_t depth = 0;          // levels, 0 for an empty root
+        };
+
+        std::size_t nodes = 0;          // distinct nodes reachable from any root
+        std::size_t bytes = 0;          // distinct bytes reachable from any root
+        std::size_t shared_nodes = 0;   // nodes reachable from more than one root
+        std::size_t shared_bytes = 0;
+        std::size_t slots = 0;          // slots of all distinct nodes
+        std::size_t used_slots = 0;     // ... that are in use
+        std::vector<root_usage> roots;  // in the order the roots were given
+
+        // Share of the slots that are in use, 1 when there are no nodes.
+        double fill() const {
+            return slots == 0 ? 1.0 : static_cast<double>(used_slots) / slots;
+        }
+
+        // Reports every figure as `counter(name, value)`, e.g. for a metrics
+        // pipeline. Per root figures are named `<prefix>roots.<index>.<figure>`.
+        template <typename Counter>
+        void export_counters(std::string const& prefix, Counter&& counter) const {
+            counter(prefix + "nodes", static_cast<double>(nodes));
+            counter(prefix + "bytes", static_cast<double>(bytes));
+            counter(prefix + "shared_nodes", static_cast<double>(shared_nodes));
+            counter(prefix + "shared_bytes", static_cast<double>(shared_bytes));
+            counter(prefix + "fill", fill());
+
+            for(std::size_t i = 0; i < roots.size(); ++i) {
+                auto const root = prefix + "roots." + std::to_string(i) + ".";
+                counter(root + "nodes", static_cast<double>(roots[i].nodes));
+                counter(root + "bytes", static_cast<double>(roots[i].bytes));
+                counter(root + "unique_bytes", static_cast<double>(roots[i].unique_bytes));
+                counter(root + "shared_bytes", static_cast<double>(roots[i].shared_bytes));
+                counter(root + "depth", static_cast<double>(roots[i].depth));
+            }
+        }
+    };
+
+
+    namespace detail {
+
+        template <typename Node>
+        class memory_walk {
+        public:
+            using traits = memory_node_traits<Node>;
+
+            explicit memory_walk(memory_usage& usage)
+                : m_usage(usage)
+            {}
+
+            void add_root(Node const* root) {
+                auto const owner = m_usage.roots.size();
+                m_usage.roots.emplace_back();
+                if(root == nullptr)
+                    return;
+
+                auto const& record = visit(root, owner);
+                auto& usage = m_usage.roots.back();
+                usage.nodes = record.nodes;
+                usage.bytes = record.bytes;
+                usage.depth = record.depth;
+            }
+
+            // Splits the bytes of each root into unique and shared ones; call
+            // once after all roots were added.
+            void finish() {
+                for(auto const& seen : m_seen) {
+                    if(!seen.second.shared)
+                        m_usage.roots[seen.second.owner].unique_bytes += seen.second.own_bytes;
+                }
+                for(auto& root : m_usage.roots)
+                    root.shared_bytes = root.bytes - root.unique_bytes;
+            }
+
+        private:
+            struct record {
+                std::size_t own_bytes;
+                std::size_t nodes;      // of the subtree
+                std::size_t bytes;      // of the subtree
+                std::size_t depth;      // of the subtree
+                std::size_t owner;      // first root that reached the node
+                bool shared;            // reached from another root as well
+            };
+
+            record const& visit(Node const* node, std::size_t owner) {
+                auto seen = m_seen.find(node);
+                if(seen != m_seen.end()) {
+                    if(seen->second.owner != owner)
+                        share(seen->second, *node);
+                    return seen->second;
+                }
+
+                auto const bytes = traits::bytes(*node);
+                // references into an unordered_map stay valid across inserts
+                auto& result = m_seen.emplace(node, record{ bytes, 1, bytes, 1, owner, false }).first->second;
+
+                m_usage.nodes += 1;
+                m_usage.bytes += bytes;
+                m_usage.slots += traits::capacity(*node);
+                m_usage.used_slots += traits::size(*node);
+
+                std::size_t nodes = 0;
+                std::size_t subtree_bytes = 0;
+                std::size_t depth = 0;
+                traits::for_each_child(*node, [&](Node const* child) {
+                    if(child == nullptr)
+                        return;
+
+                    auto const& child_record = visit(child, owner);
+                    nodes += child_record.nodes;
+                    subtree_bytes += child_record.bytes;
+                    depth = std::max(depth, child_record.depth);
+                });
+
+                result.nodes += nodes;
+                result.bytes += subtree_bytes;
+                result.depth += depth;
+                return result;
+            }
+
+            // Everything below a shared node is shared as well. Each node is
+            // marked at most once, so the walk stays linear in the nodes.
+            void share(record& shared, Node const& node) {
+                if(shared.shared)
+                    return;
+
+                shared.shared = true;
+                m_usage.shared_nodes += 1;
+                m_usage.shared_bytes += shared.own_bytes;
+
+                traits::for_each_child(node, [&](Node const* child) {
+                    if(child != nullptr)
+                        share(m_seen.at(child), *child);
+                });
+            }
+
+            memory_usage& m_usage;
+            std::unordered_map<Node const*, record> m_seen;
+        };
+    }
+
+
+    namespace detail {
+
+        template <typename Node>
+        Node const* root_address(Node const* root) {
+            return root;
+        }
+
+        // smart pointers, e.g. std::shared_ptr<node const>
+        template <typename Pointer>
+        auto root_address(Pointer const& root) -> decltype(root.get()) {
+            return root.get();
+        }
+    }
+
+
+    // Walks the nodes reachable from the given roots, visiting every node
+    // once, and reports how much memory they take together and per root.
+    // Roots are raw or smart pointers to nodes and may be null, e.g. for an
+    // empty container.
+    template <typename InputIt>
+    memory_usage measure_memory(InputIt first, InputIt last) {
+        using Pointer = typename std::iterator_traits<InputIt>::value_type;
+        using Node = std::remove_cv_t<typename std::pointer_traits<Pointer>::element_type>;
+
+        memory_usage usage;
+        detail::memory_walk<Node> walk{usage};
+        for(; first != last; ++first)
+            walk.add_root(detail::root_address(*first));
+        walk.finish();
+        return usage;
+    }
+
+    template <typename Pointer>
+    memory_usage measure_memory(std::initializer_list<Pointer> roots) {
+        return measure_memory(roots.begin(), roots.end());
+    }
+
+}
@@ -0,0 +1,163 @@
+#include <catch.hpp>
+#include <immutable-vector/memory_usage.h>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace imm;
+
+namespace {
+    // a minimal persistent tree: leaves hold up to four values, inner nodes
+    // up to four children
+    struct node {
+        std::vector<std::shared_ptr<node const>> children;
+        std::vector<int> values;
+    };
+
+    using node_ptr = std::shared_ptr<node const>;
+
+    node_ptr leaf(std::vector<int> values) {
+        return std::make_shared<node const>(node{ {}, std::move(values) });
+    }
+
+    node_ptr inner(std::vector<node_ptr> children) {
+        return std::make_shared<node const>(node{ std::move(children), {} });
+    }
+}
+
+namespace imm {
+    template <>
+    struct memory_node_traits<node> {
+        static std::size_t bytes(node const& n) {
+            return sizeof(node) + n.children.size() * sizeof(node_ptr) + n.values.size() * sizeof(int);
+        }
+
+        static std::size_t capacity(node const&) { return 4; }
+
+        static std::size_t size(node const& n) { return n.children.size() + n.values.size(); }
+
+        template <typename Visit>
+        static void for_each_child(node const& n, Visit&& visit) {
+            for(auto const& child : n.children)
+                visit(child.get());
+        }
+    };
+}
+
+TEST_CASE("measure_memory of a single root", "[memory-usage]") {
+    GIVEN("a tree of one inner node and two leaves") {
+        auto const root = inner({ leaf({ 1, 2, 3, 4 }), leaf({ 5, 6 }) });
+        auto const usage = measure_memory({ root.get() });
+
+        THEN("every node is counted, nothing is shared") {
+            auto const bytes = 3 * sizeof(node) + 2 * sizeof(node_ptr) + 6 * sizeof(int);
+            CHECK(usage.nodes == 3);
+            CHECK(usage.bytes == bytes);
+            CHECK(usage.shared_nodes == 0);
+            CHECK(usage.shared_bytes == 0);
+            REQUIRE(usage.roots.size() == 1);
+            CHECK(usage.roots[0].nodes == 3);
+            CHECK(usage.roots[0].bytes == bytes);
+            CHECK(usage.roots[0].unique_bytes == bytes);
+            CHECK(usage.roots[0].shared_bytes == 0);
+            CHECK(usage.roots[0].depth == 2);
+        }
+
+        THEN("the fill is the share of slots in use") {
+            CHECK(usage.slots == 12);
+            CHECK(usage.used_slots == 8);
+            REQUIRE(usage.fill() == Approx(8.0 / 12.0));
+        }
+    }
+}
+
+TEST_CASE("measure_memory of versions sharing nodes", "[memory-usage]") {
+    GIVEN("two versions that differ only in their last leaf") {
+        auto const shared = inner({ leaf({ 1, 2, 3, 4 }), leaf({ 5, 6, 7, 8 }) });
+        auto const v1 = inner({ shared, leaf({ 9 }) });
+        auto const v2 = inner({ shared, leaf({ 9, 10 }) });
+
+        auto const usage = measure_memory({ v1.get(), v2.get() });
+
+        THEN("shared nodes are counted once") {
+            CHECK(usage.nodes == 7);
+            CHECK(usage.shared_nodes == 3);
+            CHECK(usage.shared_bytes == memory_node_traits<node>::bytes(*shared)
+                                      + 2 * (sizeof(node) + 4 * sizeof(int)));
+        }
+
+        THEN("each root reports its own and its shared bytes") {
+            REQUIRE(usage.roots.size() == 2);
+            for(auto const& root : usage.roots) {
+                CHECK(root.nodes == 5);
+                CHECK(root.depth == 3);
+                CHECK(root.shared_bytes == usage.shared_bytes);
+                CHECK(root.unique_bytes + root.shared_bytes == root.bytes);
+            }
+            CHECK(usage.roots[1].unique_bytes == usage.roots[0].unique_bytes + sizeof(int));
+            REQUIRE(usage.bytes == usage.shared_bytes + usage.roots[0].unique_bytes + usage.roots[1].unique_bytes);
+        }
+    }
+
+    GIVEN("the same root given twice and an empty root") {
+        auto const root = inner({ leaf({ 1 }) });
+        std::vector<node const*> const roots{ root.get(), nullptr, root.get() };
+        auto const usage = measure_memory(roots.begin(), roots.end());
+
+        THEN("everything is shared and the empty root costs nothing") {
+            REQUIRE(usage.roots.size() == 3);
+            CHECK(usage.nodes == 2);
+            CHECK(usage.shared_nodes == 2);
+            CHECK(usage.roots[0].unique_bytes == 0);
+            CHECK(usage.roots[1].bytes == 0);
+            CHECK(usage.roots[1].depth == 0);
+            REQUIRE(usage.roots[2].shared_bytes == usage.bytes);
+        }
+    }
+}
+
+TEST_CASE("measure_memory of smart pointer roots", "[memory-usage]") {
+    GIVEN("versions held as shared_ptr, as a persistent container holds them") {
+        auto const shared = leaf({ 1, 2, 3, 4 });
+        std::vector<node_ptr> const versions{ inner({ shared, leaf({ 5 }) }), inner({ shared }), nullptr };
+
+        THEN("they can be passed without converting them to raw pointers") {
+            auto const from_range = measure_memory(versions.begin(), versions.end());
+            auto const from_list = measure_memory({ versions[0], versions[1], versions[2] });
+            auto const from_raw = measure_memory({ versions[0].get(), versions[1].get(), versions[2].get() });
+
+            for(auto const& usage : { from_range, from_list }) {
+                CHECK(usage.nodes == from_raw.nodes);
+                CHECK(usage.bytes == from_raw.bytes);
+                CHECK(usage.shared_nodes == 1);
+                REQUIRE(usage.roots.size() == 3);
+                CHECK(usage.roots[0].unique_bytes == from_raw.roots[0].unique_bytes);
+                REQUIRE(usage.roots[2].bytes == 0);
+            }
+        }
+    }
+}
+
+TEST_CASE("memory_usage export_counters", "[memory-usage]") {
+    GIVEN("the usage of two roots") {
+        auto const v1 = inner({ leaf({ 1 }) });
+        auto const v2 = inner({ v1, leaf({ 2 }) });
+        auto const usage = measure_memory({ v1.get(), v2.get() });
+
+        WHEN("the counters are exported") {
+            std::map<std::string, double> counters;
+            usage.export_counters("imm.", [&](std::string const& name, double value) {
+                counters[name] = value;
+            });
+
+            THEN("there are totals and per root figures") {
+                CHECK(counters.at("imm.nodes") == 4);
+                CHECK(counters.at("imm.shared_nodes") == 2);
+                CHECK(counters.at("imm.roots.0.unique_bytes") == 0);
+                CHECK(counters.at("imm.roots.1.depth") == 3);
+                REQUIRE(counters.size() == 5 + 2 * 5);
+            }
+        }
+    }
+}